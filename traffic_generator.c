@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+//                      SYNTHETIC TRAFFIC GENERATOR
+//
+// Writes "<x_coordinate> <speed>" lines in the format read by load_points in veb_tree.c.
+// The same arguments always produce the same file, so runs can be compared with each other.
+
+#define Max_distance 30000
+#define ramp_spacing 5000 // Distance between two on-ramps in meters
+
+// splitmix64, used instead of rand() so the output does not depend on the C library
+typedef struct Generator
+{
+    uint64_t state;
+} Generator;
+
+uint64_t next_random(Generator *g)
+{
+    uint64_t z = (g->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Function to return a uniform integer in [lo, hi]
+int random_between(Generator *g, int lo, int hi)
+{
+    if (hi <= lo)
+        return lo;
+    return lo + (int)(next_random(g) % (uint64_t)(hi - lo + 1));
+}
+
+// Function to return a speed around the mean, never negative
+int random_speed(Generator *g, int mean_speed, int speed_spread)
+{
+    int speed = random_between(g, mean_speed - speed_spread, mean_speed + speed_spread);
+    return speed < 0 ? 0 : speed;
+}
+
+// Vehicles spread evenly over the whole road
+void generate_uniform(Generator *g, FILE *out, long n, int mean_speed, int speed_spread)
+{
+    for (long i = 0; i < n; i++)
+    {
+        fprintf(out, "%d %d\n", random_between(g, 0, Max_distance), random_speed(g, mean_speed, speed_spread));
+    }
+}
+
+// Groups of 5 to 20 vehicles driving close together at a shared speed
+void generate_platoons(Generator *g, FILE *out, long n, int mean_speed, int speed_spread)
+{
+    long i = 0;
+    while (i < n)
+    {
+        int size = random_between(g, 5, 20);
+        // Leader far enough ahead that the whole platoon (at most 30 m per gap) stays on the road
+        int x = random_between(g, 30 * (size - 1), Max_distance);
+        int speed = random_speed(g, mean_speed, speed_spread);
+        for (int j = 0; j < size && i < n; j++, i++)
+        {
+            fprintf(out, "%d %d\n", x, random_speed(g, speed, 1));
+            x -= random_between(g, 10, 30);
+        }
+    }
+}
+
+// Slow clusters: half of the vehicles are packed into a few jams moving at 0 to 5 m/s, the rest flow freely.
+// Every vehicle keeps its speed for the whole run, so the jams drift but never stop and restart.
+void generate_jams(Generator *g, FILE *out, long n, int mean_speed, int speed_spread)
+{
+    int num_jams = random_between(g, 2, 6);
+    int jam_start[6];
+    int jam_length[6];
+    for (int j = 0; j < num_jams; j++)
+    {
+        jam_start[j] = random_between(g, 0, Max_distance - 2000);
+        jam_length[j] = random_between(g, 300, 2000);
+    }
+
+    for (long i = 0; i < n; i++)
+    {
+        if (next_random(g) % 2)
+        {
+            int j = random_between(g, 0, num_jams - 1);
+            int x = jam_start[j] + random_between(g, 0, jam_length[j]);
+            fprintf(out, "%d %d\n", x, random_between(g, 0, 5));
+        }
+        else
+        {
+            fprintf(out, "%d %d\n", random_between(g, 0, Max_distance), random_speed(g, mean_speed, speed_spread));
+        }
+    }
+}
+
+// Bursts of merging vehicles just behind the on-ramps, driving at half of mean_speed
+// Every vehicle keeps one fixed speed, so they do not accelerate after merging
+void generate_onramps(Generator *g, FILE *out, long n, int mean_speed, int speed_spread)
+{
+    int num_ramps = Max_distance / ramp_spacing;
+    long i = 0;
+    while (i < n)
+    {
+        int ramp = random_between(g, 0, num_ramps - 1) * ramp_spacing;
+        int burst = random_between(g, 10, 100);
+        for (int j = 0; j < burst && i < n; j++, i++)
+        {
+            int x = ramp + random_between(g, 0, 400);
+            fprintf(out, "%d %d\n", x, random_speed(g, mean_speed / 2, speed_spread));
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <vehicles> <uniform|platoon|jam|onramp> [seed] [mean_speed] [speed_spread]\n", argv[0]);
+        return 1;
+    }
+
+    long n = atol(argv[1]);
+    const char *distribution = argv[2];
+    Generator g;
+    g.state = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+    int mean_speed = argc > 4 ? atoi(argv[4]) : 25;   // m/s
+    int speed_spread = argc > 5 ? atoi(argv[5]) : 10; // m/s either side of the mean
+
+    if (strcmp(distribution, "uniform") == 0)
+        generate_uniform(&g, stdout, n, mean_speed, speed_spread);
+    else if (strcmp(distribution, "platoon") == 0)
+        generate_platoons(&g, stdout, n, mean_speed, speed_spread);
+    else if (strcmp(distribution, "jam") == 0)
+        generate_jams(&g, stdout, n, mean_speed, speed_spread);
+    else if (strcmp(distribution, "onramp") == 0)
+        generate_onramps(&g, stdout, n, mean_speed, speed_spread);
+    else
+    {
+        fprintf(stderr, "Unknown distribution: %s\n", distribution);
+        return 1;
+    }
+
+    return 0;
+}
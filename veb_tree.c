@@ -3,6 +3,10 @@
 #include <math.h>
 #include <unistd.h> // For sleep function
 #include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
 // Define Van Emde Boas Tree structure
 typedef struct vEBTree
@@ -10,6 +14,8 @@ typedef struct vEBTree
     int u;
     int min;
     int max;
+    unsigned epoch;        // Incremented by vEB_clear, the summary and clusters of an older epoch are empty
+    unsigned parent_epoch; // Epoch of the parent when this node was last emptied or written
     struct vEBTree *summary;
     struct vEBTree **clusters;
 } vEBTree;
@@ -45,6 +51,8 @@ vEBTree *create_vEB(int size)
     vEB->u = size;
     vEB->min = -1;
     vEB->max = -1;
+    vEB->epoch = 0;
+    vEB->parent_epoch = 0;
 
     if (size <= 2)
     {
@@ -77,6 +85,29 @@ int vEB_max(vEBTree *vEB)
     return (vEB->max == -1 ? -1 : vEB->max);
 }
 
+// Function to return child of parent, emptied first if parent was cleared since it was last reached
+vEBTree *fresh_child(vEBTree *parent, vEBTree *child)
+{
+    if (child->parent_epoch != parent->epoch)
+    {
+        child->min = -1;
+        child->max = -1;
+        child->epoch++; // Its own children become stale in turn
+        child->parent_epoch = parent->epoch;
+    }
+    return child;
+}
+
+vEBTree *get_cluster(vEBTree *vEB, int c)
+{
+    return fresh_child(vEB, vEB->clusters[c]);
+}
+
+vEBTree *get_summary(vEBTree *vEB)
+{
+    return fresh_child(vEB, vEB->summary);
+}
+
 // Key insertion for traffic congestion management
 void insert(vEBTree *vEB, int key)
 {
@@ -99,15 +130,16 @@ void insert(vEBTree *vEB, int key)
 
         if (vEB->u > 2)
         {
-            if (vEB_min(vEB->clusters[high(vEB, key)]) == -1)
+            vEBTree *cluster = get_cluster(vEB, high(vEB, key));
+            if (vEB_min(cluster) == -1)
             {
-                insert(vEB->summary, high(vEB, key));
-                vEB->clusters[high(vEB, key)]->min = low(vEB, key);
-                vEB->clusters[high(vEB, key)]->max = low(vEB, key);
+                insert(get_summary(vEB), high(vEB, key));
+                cluster->min = low(vEB, key);
+                cluster->max = low(vEB, key);
             }
             else
             {
-                insert(vEB->clusters[high(vEB, key)], low(vEB, key));
+                insert(cluster, low(vEB, key));
             }
         }
 
@@ -134,7 +166,7 @@ int isMember(vEBTree *vEB, int key)
     }
     else
     {
-        return isMember(vEB->clusters[high(vEB, key)], low(vEB, key));
+        return isMember(get_cluster(vEB, high(vEB, key)), low(vEB, key));
     }
 }
 
@@ -157,18 +189,18 @@ int vEB_successor(vEBTree *vEB, int key)
     }
     else
     {
-        int max_incluster = vEB_max(vEB->clusters[high(vEB, key)]);
+        int max_incluster = vEB_max(get_cluster(vEB, high(vEB, key)));
         if (max_incluster != -1 && low(vEB, key) < max_incluster)
         {
-            int offset = vEB_successor(vEB->clusters[high(vEB, key)], low(vEB, key));
+            int offset = vEB_successor(get_cluster(vEB, high(vEB, key)), low(vEB, key));
             return generate_index(vEB, high(vEB, key), offset);
         }
         else
         {
-            int succ_cluster = vEB_successor(vEB->summary, high(vEB, key));
+            int succ_cluster = vEB_successor(get_summary(vEB), high(vEB, key));
             if (succ_cluster == -1)
                 return -1;
-            int offset = vEB_min(vEB->clusters[succ_cluster]);
+            int offset = vEB_min(get_cluster(vEB, succ_cluster));
             return generate_index(vEB, succ_cluster, offset);
         }
     }
@@ -197,202 +229,2106 @@ void vEB_delete(vEBTree *veb, int key)
     {
         if (key == veb->min)
         {
-            int first_cluster = vEB_min(veb->summary);
-            key = generate_index(veb, first_cluster, vEB_min(veb->clusters[first_cluster]));
+            int first_cluster = vEB_min(get_summary(veb));
+            key = generate_index(veb, first_cluster, vEB_min(get_cluster(veb, first_cluster)));
             veb->min = key;
         }
 
-        vEB_delete(veb->clusters[high(veb, key)], low(veb, key));
+        vEB_delete(get_cluster(veb, high(veb, key)), low(veb, key));
 
-        if (vEB_min(veb->clusters[high(veb, key)]) == -1)
+        if (vEB_min(get_cluster(veb, high(veb, key))) == -1)
         {
-            vEB_delete(veb->summary, high(veb, key));
+            vEB_delete(get_summary(veb), high(veb, key));
             if (key == veb->max)
             {
-                int max_in_summary = vEB_max(veb->summary);
-                veb->max = (max_in_summary == -1) ? veb->min : generate_index(veb, max_in_summary, vEB_max(veb->clusters[max_in_summary]));
+                int max_in_summary = vEB_max(get_summary(veb));
+                veb->max = (max_in_summary == -1) ? veb->min : generate_index(veb, max_in_summary, vEB_max(get_cluster(veb, max_in_summary)));
             }
         }
         else if (key == veb->max)
         {
-            veb->max = generate_index(veb, high(veb, key), vEB_max(veb->clusters[high(veb, key)]));
+            veb->max = generate_index(veb, high(veb, key), vEB_max(get_cluster(veb, high(veb, key))));
         }
     }
 }
 
-// Cleanup function to free memory allocated to Van Emde Boas tree
-void free_vEB(vEBTree *vEB)
+// Function to empty a whole tree in O(1)
+// The node moves to a new epoch, which leaves its summary and clusters stale. Each of them
+// is emptied by fresh_child only when an insert, query or delete reaches it again.
+void vEB_clear(vEBTree *veb)
 {
-    if (!vEB)
+    if (!veb || veb->min == -1)
         return;
 
-    if (vEB->clusters)
+    veb->min = -1;
+    veb->max = -1;
+    veb->epoch++;
+}
+
+// Function to delete every key in [lo, hi]
+// Clusters inside the range are emptied whole by vEB_clear, so the cost grows with the
+// non-empty clusters the range covers and not with the number of keys in them. Only the
+// two clusters at the ends of the range are split further, on every level.
+void vEB_delete_range(vEBTree *veb, int lo, int hi)
+{
+    if (!veb || veb->min == -1 || lo > hi || hi < veb->min || lo > veb->max)
+        return;
+
+    if (lo <= veb->min && veb->max <= hi)
     {
-        int num_clusters = (int)ceil(sqrt(vEB->u));
-        for (int i = 0; i < num_clusters; i++)
+        vEB_clear(veb);
+        return;
+    }
+
+    // Partly covered, so min != max and exactly one of them goes
+    if (veb->u == 2)
+    {
+        vEB_delete(veb, (hi >= 1) ? 1 : 0);
+        return;
+    }
+
+    if (lo < veb->min)
+        lo = veb->min;
+    if (hi > veb->max)
+        hi = veb->max;
+
+    bool min_removed = (lo == veb->min);
+    int ru = (int)ceil(sqrt(veb->u));
+    int lo_cluster = high(veb, lo);
+    int hi_cluster = high(veb, hi);
+    vEBTree *summary = get_summary(veb);
+
+    // First cluster, only partly covered when the range ends in another cluster
+    vEBTree *first = get_cluster(veb, lo_cluster);
+    if (vEB_min(first) != -1)
+    {
+        vEB_delete_range(first, low(veb, lo), lo_cluster == hi_cluster ? low(veb, hi) : ru - 1);
+        if (vEB_min(first) == -1)
+            vEB_delete(summary, lo_cluster);
+    }
+
+    if (lo_cluster != hi_cluster)
+    {
+        // Clusters strictly between the two ends are emptied as a whole
+        if (lo_cluster + 1 <= hi_cluster - 1)
         {
-            free_vEB(vEB->clusters[i]);
+            for (int c = vEB_successor(summary, lo_cluster); c != -1 && c < hi_cluster; c = vEB_successor(summary, c))
+            {
+                vEB_clear(get_cluster(veb, c));
+            }
+            vEB_delete_range(summary, lo_cluster + 1, hi_cluster - 1);
+        }
+
+        vEBTree *last = get_cluster(veb, hi_cluster);
+        if (vEB_min(last) != -1)
+        {
+            vEB_delete_range(last, 0, low(veb, hi));
+            if (vEB_min(last) == -1)
+                vEB_delete(summary, hi_cluster);
         }
-        free(vEB->clusters);
     }
 
-    free_vEB(vEB->summary);
-    free(vEB);
+    // The new min is pulled out of the first non-empty cluster, as in vEB_delete
+    if (min_removed)
+    {
+        int first_cluster = vEB_min(summary);
+        if (first_cluster == -1)
+        {
+            veb->min = -1;
+            veb->max = -1;
+            return;
+        }
+        vEBTree *cluster = get_cluster(veb, first_cluster);
+        int offset = vEB_min(cluster);
+        veb->min = generate_index(veb, first_cluster, offset);
+        vEB_delete(cluster, offset);
+        if (vEB_min(cluster) == -1)
+            vEB_delete(summary, first_cluster);
+    }
+
+    int last_cluster = vEB_max(summary);
+    veb->max = (last_cluster == -1) ? veb->min : generate_index(veb, last_cluster, vEB_max(get_cluster(veb, last_cluster)));
 }
 
-//                      TRAFFIC CONGESTION ALERT IMPLEMENTATION
+//                      BATCHED SUCCESSOR QUERIES
 
-#define Max_distance 30000
-#define min_dist 1000
-#define max_dist 3000
+#define BATCH_GROUP 16     // Number of queries advanced together
+#define BATCH_MAX_DEPTH 32 // Nodes on the path of one query, ample for any int universe
 
-// Define a point with only an x-coordinate and speed
-typedef struct Point
+#if defined(__GNUC__)
+#define VEB_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define VEB_PREFETCH(p) ((void)(p))
+#endif
+
+// vEB_successor split into steps that each touch one new node. Every step
+// issues a prefetch for the node the next step of the same query needs and
+// then moves on to another query, so the cache misses of BATCH_GROUP
+// independent queries are overlapped instead of taken one after the other.
+// The bookkeeping per step is heavier than the recursive vEB_successor, so
+// whether a batch is faster depends on the tree being too large for the cache.
+// No benchmark for this is kept in the repository.
+typedef enum QueryStep
 {
-    int x;
-    int speed;
-} Point;
+    STEP_DESCEND, // Look at node and prefetch the cluster of the key
+    STEP_DECIDE,  // Go down into the cluster or into the summary
+    STEP_RESOLVE, // Summary answered: take the minimum of the cluster it found
+    STEP_DONE
+} QueryStep;
 
-// Function to load points from input file
-void load_points(const char *filename, Point points[], int *n)
+typedef struct SuccessorQuery
 {
-    FILE *file = fopen(filename, "r");
-    if (!file)
+    QueryStep step;
+    int id;       // Position of the query in the caller's arrays
+    vEBTree *node;
+    int key;
+    int ru;       // Cluster size of node, computed once per node
+    int cluster_index;
+    vEBTree *cluster;
+    int depth;
+    vEBTree *path_node[BATCH_MAX_DEPTH];
+    int path_cluster[BATCH_MAX_DEPTH]; // Cluster entered from path_node, -1 for the summary
+    int path_ru[BATCH_MAX_DEPTH];
+    int upper;    // Range counting only: keys up to upper are counted
+    int count;
+    int result;
+} SuccessorQuery;
+
+void batch_start(vEBTree *veb, SuccessorQuery *q, int key)
+{
+    q->depth = 0;
+    if (key >= veb->u - 1)
     {
-        perror("Error opening file");
-        exit(1);
+        q->result = -1;
+        q->step = STEP_DONE;
     }
-
-    *n = 0;
-    while (fscanf(file, "%d %d", &points[*n].x, &points[*n].speed) != EOF && *n < 100)
+    else if (key < 0)
+    {
+        q->result = vEB_min(veb);
+        q->step = STEP_DONE;
+    }
+    else
     {
-        (*n)++;
+        q->node = veb;
+        q->key = key;
+        q->step = STEP_DESCEND;
     }
+}
 
-    fclose(file);
+// Walks back up the path with result r, stops early when a summary answer needs its cluster
+void batch_unwind(SuccessorQuery *q, int r)
+{
+    while (q->depth > 0)
+    {
+        vEBTree *node = q->path_node[q->depth - 1];
+        int c = q->path_cluster[q->depth - 1];
+        if (r != -1 && c == -1)
+        {
+            q->node = node;
+            q->ru = q->path_ru[q->depth - 1];
+            q->cluster_index = r;
+            q->cluster = node->clusters[r];
+            VEB_PREFETCH(q->cluster);
+            q->step = STEP_RESOLVE;
+            return;
+        }
+        if (r != -1)
+            r = c * q->path_ru[q->depth - 1] + r;
+        q->depth--;
+    }
+    q->result = r;
+    q->step = STEP_DONE;
 }
 
-// Function to count vehicles within a specific range of distances using successor function in Van Emde Boas tree
-int count_vehicles_in_range(vEBTree *veb_tree, int input_distance, int min_distance, int max_distance)
+// Advances one query by one step
+void batch_step(SuccessorQuery *q)
 {
-    if (!veb_tree)
-        return 0;
-    int count = 0;
+    vEBTree *node = q->node;
+    switch (q->step)
+    {
+    case STEP_DESCEND:
+        if (q->depth > 0)
+            fresh_child(q->path_node[q->depth - 1], node);
+        if (node->u == 2)
+        {
+            batch_unwind(q, (q->key == 0 && node->max == 1) ? 1 : -1);
+        }
+        else if (node->min != -1 && q->key < node->min)
+        {
+            batch_unwind(q, node->min);
+        }
+        else
+        {
+            q->ru = (int)ceil(sqrt(node->u));
+            q->cluster_index = q->key / q->ru;
+            q->cluster = node->clusters[q->cluster_index];
+            VEB_PREFETCH(q->cluster);
+            q->step = STEP_DECIDE;
+        }
+        break;
+    case STEP_DECIDE:
+    {
+        int max_incluster = vEB_max(fresh_child(node, q->cluster));
+        q->path_node[q->depth] = node;
+        q->path_ru[q->depth] = q->ru;
+        if (max_incluster != -1 && q->key % q->ru < max_incluster)
+        {
+            q->path_cluster[q->depth++] = q->cluster_index;
+            q->key = q->key % q->ru;
+            q->node = q->cluster;
+        }
+        else
+        {
+            q->path_cluster[q->depth++] = -1;
+            q->key = q->cluster_index;
+            q->node = node->summary;
+            VEB_PREFETCH(q->node);
+        }
+        q->step = STEP_DESCEND;
+        break;
+    }
+    case STEP_RESOLVE:
+        q->depth--;
+        batch_unwind(q, q->cluster_index * q->ru + vEB_min(fresh_child(node, q->cluster)));
+        break;
+    default:
+        break;
+    }
+}
 
-    // Calculate the actual distances from input_x to search within
-    int lower_bound = input_distance + min_distance;
-    int upper_bound = input_distance + max_distance;
+// Runs n queries in groups of BATCH_GROUP, a finished slot is refilled with the next query.
+// With uppers == NULL out[i] is the successor of keys[i], otherwise it is the number of
+// keys in (keys[i], uppers[i]].
+void batch_run(vEBTree *veb, const int *keys, const int *uppers, int *out, int n)
+{
+    SuccessorQuery group[BATCH_GROUP];
+    int next = 0;
+    int active = 0;
 
-    // Start finding successors from the lower_bound
-    int current_distance = vEB_successor(veb_tree, lower_bound - 1);
+    while (active < BATCH_GROUP && next < n)
+    {
+        SuccessorQuery *q = &group[active++];
+        q->id = next;
+        q->upper = uppers ? uppers[next] : 0;
+        q->count = 0;
+        batch_start(veb, q, keys[next++]);
+    }
 
-    while (current_distance != -1 && current_distance <= upper_bound)
+    while (active > 0)
     {
-        count++;
-        current_distance = vEB_successor(veb_tree, current_distance);
+        for (int i = 0; i < active; i++)
+        {
+            SuccessorQuery *q = &group[i];
+            batch_step(q);
+            if (q->step != STEP_DONE)
+                continue;
+
+            // A range query keeps walking from the key it just found
+            if (uppers && q->result != -1 && q->result <= q->upper)
+            {
+                q->count++;
+                batch_start(veb, q, q->result);
+                continue;
+            }
+
+            out[q->id] = uppers ? q->count : q->result;
+            if (next < n)
+            {
+                q->id = next;
+                q->upper = uppers ? uppers[next] : 0;
+                q->count = 0;
+                batch_start(veb, q, keys[next++]);
+            }
+            else
+            {
+                group[i--] = group[--active];
+            }
+        }
     }
+}
 
-    return count;
+// Function to find the successors of n independent keys at once
+void vEB_successor_batch(vEBTree *veb, const int *keys, int *results, int n)
+{
+    if (!veb)
+        return;
+    batch_run(veb, keys, NULL, results, n);
 }
 
-// Function to print all elements in the Van Emde Boas tree in sorted order
-void print_all_elements(vEBTree *vEB)
+// Function to count the keys in [lo[i], hi[i]] for n independent ranges at once
+// Each key found restarts the walk from the root, so a range still costs one full
+// successor walk per key it contains. Only the walks of different ranges overlap.
+void vEB_range_count_batch(vEBTree *veb, const int *lo, const int *hi, int *counts, int n)
 {
-    if (!vEB)
+    if (!veb)
         return;
-    int current = vEB_min(vEB); // Start from the minimum element
 
-    // Traverse through all elements using successor function
-    while (current != -1)
+    int *keys = (int *)malloc((n ? n : 1) * sizeof(int));
+    for (int i = 0; i < n; i++)
     {
-        printf("%d ", current);                // Print the current element
-        current = vEB_successor(vEB, current); // Move to the next element
+        keys[i] = lo[i] - 1;
     }
-    printf("\n"); // Newline after printing all elements
+    batch_run(veb, keys, hi, counts, n);
+    free(keys);
 }
 
-int main()
+// Cleanup function to free memory allocated to Van Emde Boas tree
+void free_vEB(vEBTree *vEB)
 {
+    if (!vEB)
+        return;
 
-    Point points[100]; // Assuming a max of 100 vehicles
-    int num_points;
+    if (vEB->clusters)
+    {
+        int num_clusters = (int)ceil(sqrt(vEB->u));
+        for (int i = 0; i < num_clusters; i++)
+        {
+            free_vEB(vEB->clusters[i]);
+        }
+        free(vEB->clusters);
+    }
 
-    // Load points from input file
-    load_points("input.txt", points, &num_points);
-    printf("Number of vehicles loaded: %d\n", num_points);
+    free_vEB(vEB->summary);
+    free(vEB);
+}
 
-    float input_x;
-    int input_speed;
-    printf("Enter the x_coordinate(in km) of vehicle to check for congestion between 0 to 30 km: ");
+//                      ADAPTIVE ORDERED SET
 
-    scanf("%f", &input_x);
-    printf("Enter speed(m/s) of vehicle whose coordinate you have given: ");
-    scanf("%d", &input_speed);
+#define ADAPTIVE_REGION_SIZE 4096 // Number of keys covered by one region
+#define ADAPTIVE_ARRAY_LIMIT 32   // Largest region stored as a sorted array
+#define ADAPTIVE_DENSE_RATIO 32   // Regions with more than one key per 32 positions become a bitset
 
-    int congestion_threshold;
-    printf("Enter the Congestion threshold: ");
-    scanf("%d", &congestion_threshold);
+// A region is migrated between representations as its occupancy changes.
+// The thresholds used to go back are half of the ones used to go forward,
+// so a region oscillating around a threshold is not rebuilt on every update.
+typedef enum RegionKind
+{
+    REGION_ARRAY,
+    REGION_VEB,
+    REGION_BITSET
+} RegionKind;
 
-    // Check congestion after updating positions
-    int input_time;
-    printf("Enter for how many seconds you want to run the program: ");
-    scanf("%d", &input_time);
+typedef struct AdaptiveRegion
+{
+    RegionKind kind;
+    int size;       // Number of positions covered by the region
+    int count;      // Number of keys stored in the region
+    int *keys;      // REGION_ARRAY: sorted keys
+    vEBTree *tree;  // REGION_VEB
+    uint64_t *bits; // REGION_BITSET: one bit per position
+} AdaptiveRegion;
 
-    input_x *= 1000;                 // convert km to m
-    bool deleted_points[num_points]; // To keep track of deleted points
-    for (int i = 0; i < num_points; i++)
+typedef struct AdaptiveSet
+{
+    int u;
+    int num_regions;
+    vEBTree *summary; // Regions holding at least one key
+    AdaptiveRegion *regions;
+} AdaptiveSet;
+
+// Function to create an empty set, every region starts as an empty sorted array
+AdaptiveSet *create_adaptive(int size)
+{
+    if (size <= 0)
+        return NULL;
+
+    AdaptiveSet *set = (AdaptiveSet *)malloc(sizeof(AdaptiveSet));
+    set->u = size;
+    set->num_regions = (size + ADAPTIVE_REGION_SIZE - 1) / ADAPTIVE_REGION_SIZE;
+    set->summary = create_vEB(set->num_regions < 2 ? 2 : set->num_regions);
+    set->regions = (AdaptiveRegion *)calloc(set->num_regions, sizeof(AdaptiveRegion));
+    for (int i = 0; i < set->num_regions; i++)
     {
-        deleted_points[i] = false;
+        int start = i * ADAPTIVE_REGION_SIZE;
+        set->regions[i].kind = REGION_ARRAY;
+        set->regions[i].size = (size - start < ADAPTIVE_REGION_SIZE) ? size - start : ADAPTIVE_REGION_SIZE;
     }
+    return set;
+}
 
-    // Open delete file initially in write mode to create a new file for this run
-    FILE *delete_file = fopen("delete_output.txt", "w");
-    if (!delete_file)
+// Function to return the position of the first key >= x in a sorted array
+int lower_bound_index(int *keys, int n, int x)
+{
+    int lo = 0, hi = n;
+    while (lo < hi)
     {
-        perror("Error opening delete_output.txt");
-        exit(1);
+        int mid = (lo + hi) / 2;
+        if (keys[mid] < x)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
+    return lo;
+}
 
-    int t = 0;
-    int remaining_points = num_points;
-    while (t < input_time)
+int region_is_member(AdaptiveRegion *r, int x)
+{
+    if (r->count == 0)
+        return 0;
+
+    switch (r->kind)
     {
-        vEBTree *veb_tree = create_vEB(32768); // Assuming at most 30 km
-        for (int i = 0; i < num_points; i++)
+    case REGION_ARRAY:
+    {
+        int i = lower_bound_index(r->keys, r->count, x);
+        return i < r->count && r->keys[i] == x;
+    }
+    case REGION_VEB:
+        return isMember(r->tree, x);
+    default:
+        return (r->bits[x >> 6] >> (x & 63)) & 1;
+    }
+}
+
+// Function to find the smallest key of the region greater than x, x = -1 gives the minimum
+int region_successor(AdaptiveRegion *r, int x)
+{
+    if (r->count == 0 || x >= r->size - 1)
+        return -1;
+
+    switch (r->kind)
+    {
+    case REGION_ARRAY:
+    {
+        int i = lower_bound_index(r->keys, r->count, x + 1);
+        return i < r->count ? r->keys[i] : -1;
+    }
+    case REGION_VEB:
+        return x < 0 ? vEB_min(r->tree) : vEB_successor(r->tree, x);
+    default:
+    {
+        int from = x + 1;
+        int num_words = (r->size + 63) / 64;
+        uint64_t word = r->bits[from >> 6] & (~0ULL << (from & 63));
+        for (int w = from >> 6;;)
         {
-            if (points[i].x <= Max_distance)
-            {
-                insert(veb_tree, points[i].x);
-            }
-            else if (!deleted_points[i])
-            {
-                fprintf(delete_file, "Vehicle at position %d exceeded maximum distance and was removed at time %d.\n", points[i].x, t);
-                deleted_points[i] = true;
-                remaining_points--; // Decrease the number of points
-            }
+            if (word)
+                return w * 64 + __builtin_ctzll(word);
+            if (++w == num_words)
+                return -1;
+            word = r->bits[w];
         }
+    }
+    }
+}
+
+// Function to count the keys of the region in [lo, hi]
+int region_range_count(AdaptiveRegion *r, int lo, int hi)
+{
+    if (r->count == 0 || lo > hi)
+        return 0;
 
-        int count = count_vehicles_in_range(veb_tree, input_x, min_dist, max_dist);
-        printf("Number of vehicles in range: %d\n", count);
-        if (count >= congestion_threshold)
+    switch (r->kind)
+    {
+    case REGION_ARRAY:
+        return lower_bound_index(r->keys, r->count, hi + 1) - lower_bound_index(r->keys, r->count, lo);
+    case REGION_VEB:
+    {
+        int count = 0;
+        int current = region_successor(r, lo - 1);
+        while (current != -1 && current <= hi)
         {
-            printf("Congestion alert\n");
+            count++;
+            current = vEB_successor(r->tree, current);
         }
-        else
+        return count;
+    }
+    default:
+    {
+        int count = 0;
+        for (int w = lo >> 6; w <= hi >> 6; w++)
         {
-            printf("No congestion\n");
+            uint64_t word = r->bits[w];
+            if (w == lo >> 6)
+                word &= ~0ULL << (lo & 63);
+            if (w == hi >> 6 && (hi & 63) != 63)
+                word &= (1ULL << ((hi & 63) + 1)) - 1;
+            count += __builtin_popcountll(word);
         }
+        return count;
+    }
+    }
+}
 
-        printf("\n");
+// Stores key x in the current representation, the caller checked it is absent
+void region_add(AdaptiveRegion *r, int x)
+{
+    switch (r->kind)
+    {
+    case REGION_ARRAY:
+    {
+        if (!r->keys)
+            r->keys = (int *)malloc((ADAPTIVE_ARRAY_LIMIT + 1) * sizeof(int));
+        int i = lower_bound_index(r->keys, r->count, x);
+        memmove(r->keys + i + 1, r->keys + i, (r->count - i) * sizeof(int));
+        r->keys[i] = x;
+        break;
+    }
+    case REGION_VEB:
+        insert(r->tree, x);
+        break;
+    default:
+        r->bits[x >> 6] |= 1ULL << (x & 63);
+        break;
+    }
+    r->count++;
+}
 
-        if (t == input_time - 1)
-        {
-            printf("Number of vehicles remaining: %d\n", remaining_points);
-            printf("Remaining elements in the vEB Tree:\n");
-            print_all_elements(veb_tree);
-        }
+// Removes key x from the current representation, the caller checked it is present
+void region_remove(AdaptiveRegion *r, int x)
+{
+    switch (r->kind)
+    {
+    case REGION_ARRAY:
+    {
+        int i = lower_bound_index(r->keys, r->count, x);
+        memmove(r->keys + i, r->keys + i + 1, (r->count - i - 1) * sizeof(int));
+        break;
+    }
+    case REGION_VEB:
+        vEB_delete(r->tree, x);
+        break;
+    default:
+        r->bits[x >> 6] &= ~(1ULL << (x & 63));
+        break;
+    }
+    r->count--;
+}
+
+// Function to pick the representation for the current occupancy of a region
+RegionKind preferred_kind(AdaptiveRegion *r)
+{
+    int dense = r->size / ADAPTIVE_DENSE_RATIO;
+
+    switch (r->kind)
+    {
+    case REGION_ARRAY:
+        if (r->count > ADAPTIVE_ARRAY_LIMIT)
+            return r->count > dense ? REGION_BITSET : REGION_VEB;
+        return REGION_ARRAY;
+    case REGION_VEB:
+        if (r->count <= ADAPTIVE_ARRAY_LIMIT / 2)
+            return REGION_ARRAY;
+        return r->count > dense ? REGION_BITSET : REGION_VEB;
+    default:
+        if (r->count < dense / 2)
+            return r->count <= ADAPTIVE_ARRAY_LIMIT ? REGION_ARRAY : REGION_VEB;
+        return REGION_BITSET;
+    }
+}
+
+// Rebuilds the region in another representation, in time linear in its keys
+void migrate_region(AdaptiveRegion *r, RegionKind kind)
+{
+    int n = r->count;
+    int *keys = (int *)malloc((n ? n : 1) * sizeof(int));
+    for (int i = 0, current = region_successor(r, -1); i < n; i++)
+    {
+        keys[i] = current;
+        current = region_successor(r, current);
+    }
+
+    free(r->keys);
+    free_vEB(r->tree);
+    free(r->bits);
+    r->keys = NULL;
+    r->tree = NULL;
+    r->bits = NULL;
+
+    r->kind = kind;
+    r->count = 0;
+    if (kind == REGION_VEB)
+        r->tree = create_vEB(r->size);
+    else if (kind == REGION_BITSET)
+        r->bits = (uint64_t *)calloc((r->size + 63) / 64, sizeof(uint64_t));
+
+    for (int i = 0; i < n; i++)
+    {
+        region_add(r, keys[i]);
+    }
+    free(keys);
+}
 
-        free_vEB(veb_tree);
+int adaptive_is_member(AdaptiveSet *set, int key)
+{
+    if (!set || key < 0 || key >= set->u)
+        return 0;
+    return region_is_member(&set->regions[key / ADAPTIVE_REGION_SIZE], key % ADAPTIVE_REGION_SIZE);
+}
+
+// Key insertion, inserting a key twice leaves the set unchanged
+void adaptive_insert(AdaptiveSet *set, int key)
+{
+    if (!set || key < 0 || key >= set->u)
+        return;
+
+    int index = key / ADAPTIVE_REGION_SIZE;
+    AdaptiveRegion *r = &set->regions[index];
+    if (region_is_member(r, key % ADAPTIVE_REGION_SIZE))
+        return;
+
+    if (r->count == 0)
+        insert(set->summary, index);
+    region_add(r, key % ADAPTIVE_REGION_SIZE);
+
+    RegionKind kind = preferred_kind(r);
+    if (kind != r->kind)
+        migrate_region(r, kind);
+}
+
+void adaptive_delete(AdaptiveSet *set, int key)
+{
+    if (!adaptive_is_member(set, key))
+        return;
+
+    int index = key / ADAPTIVE_REGION_SIZE;
+    AdaptiveRegion *r = &set->regions[index];
+    region_remove(r, key % ADAPTIVE_REGION_SIZE);
+    if (r->count == 0)
+        vEB_delete(set->summary, index);
+
+    RegionKind kind = preferred_kind(r);
+    if (kind != r->kind)
+        migrate_region(r, kind);
+}
+
+// Function to find the successor of a given key, key = -1 gives the minimum
+int adaptive_successor(AdaptiveSet *set, int key)
+{
+    if (!set || key >= set->u - 1)
+        return -1;
+    if (key < -1)
+        key = -1;
+
+    int index = key < 0 ? 0 : key / ADAPTIVE_REGION_SIZE;
+    int start = index * ADAPTIVE_REGION_SIZE;
+    int offset = region_successor(&set->regions[index], key - start);
+    if (offset != -1)
+        return start + offset;
+
+    // The next key is the minimum of the next region holding any key
+    int next = vEB_successor(set->summary, index);
+    if (next == -1 || next >= set->num_regions)
+        return -1;
+    return next * ADAPTIVE_REGION_SIZE + region_successor(&set->regions[next], -1);
+}
+
+int adaptive_min(AdaptiveSet *set)
+{
+    return adaptive_successor(set, -1);
+}
+
+// Function to count keys in [lo, hi], whole regions in between are counted in O(1)
+int adaptive_range_count(AdaptiveSet *set, int lo, int hi)
+{
+    if (!set)
+        return 0;
+    if (lo < 0)
+        lo = 0;
+    if (hi >= set->u)
+        hi = set->u - 1;
+    if (lo > hi)
+        return 0;
+
+    int first = lo / ADAPTIVE_REGION_SIZE;
+    int last = hi / ADAPTIVE_REGION_SIZE;
+    int lo_offset = lo % ADAPTIVE_REGION_SIZE;
+    int hi_offset = hi % ADAPTIVE_REGION_SIZE;
+
+    if (first == last)
+        return region_range_count(&set->regions[first], lo_offset, hi_offset);
+
+    int count = region_range_count(&set->regions[first], lo_offset, set->regions[first].size - 1);
+    for (int i = first + 1; i < last; i++)
+    {
+        count += set->regions[i].count;
+    }
+    count += region_range_count(&set->regions[last], 0, hi_offset);
+    return count;
+}
+
+// Cleanup function to free memory allocated to the adaptive set
+void free_adaptive(AdaptiveSet *set)
+{
+    if (!set)
+        return;
+
+    for (int i = 0; i < set->num_regions; i++)
+    {
+        free(set->regions[i].keys);
+        free_vEB(set->regions[i].tree);
+        free(set->regions[i].bits);
+    }
+    free(set->regions);
+    free_vEB(set->summary);
+    free(set);
+}
+
+//                      CONCURRENT BITSET vEB
+
+#define CVEB_MAX_LEVELS 6 // Enough for 64^6 keys
+
+// Level 0 holds one bit per key and level i + 1 holds one bit per non-empty
+// word of level i, so every operation touches at most one word per level.
+// All updates are single atomic fetch_or / fetch_and operations, no locks.
+//
+// A delete that empties a word clears the parent bit and then re-checks the
+// word, setting the parent bit again if a racing insert refilled it. Readers
+// verify every word they descend into and skip words that turned out empty,
+// so a successor query never returns a key that was absent for the whole
+// query. It can only miss a key whose word is being emptied and refilled by
+// a racing delete and insert at that moment.
+typedef struct ConcurrentVEB
+{
+    int u;
+    int num_levels;
+    int level_bits[CVEB_MAX_LEVELS];
+    _Atomic uint64_t *levels[CVEB_MAX_LEVELS];
+} ConcurrentVEB;
+
+// Function to create and initialize an empty concurrent tree
+ConcurrentVEB *create_concurrent_vEB(int size)
+{
+    if (size <= 0)
+        return NULL;
+
+    ConcurrentVEB *tree = (ConcurrentVEB *)malloc(sizeof(ConcurrentVEB));
+    tree->u = size;
+    tree->num_levels = 0;
+    int bits = size;
+    do
+    {
+        int words = (bits + 63) / 64;
+        tree->level_bits[tree->num_levels] = bits;
+        tree->levels[tree->num_levels] = (_Atomic uint64_t *)calloc(words, sizeof(uint64_t));
+        tree->num_levels++;
+        bits = words;
+    } while (bits > 1 && tree->num_levels < CVEB_MAX_LEVELS);
+    return tree;
+}
+
+// Sets bit index of the level, returns the previous value of its word
+uint64_t cveb_set(ConcurrentVEB *tree, int level, int index)
+{
+    uint64_t old = atomic_fetch_or(&tree->levels[level][index >> 6], 1ULL << (index & 63));
+    if (old == 0 && level + 1 < tree->num_levels)
+        cveb_set(tree, level + 1, index >> 6);
+    return old;
+}
+
+// Clears bit index of the level, returns 1 if it was set
+int cveb_clear(ConcurrentVEB *tree, int level, int index)
+{
+    _Atomic uint64_t *word = &tree->levels[level][index >> 6];
+    uint64_t bit = 1ULL << (index & 63);
+    uint64_t old = atomic_fetch_and(word, ~bit);
+    if (!(old & bit))
+        return 0;
+
+    if (old == bit && level + 1 < tree->num_levels)
+    {
+        cveb_clear(tree, level + 1, index >> 6);
+        // A racing insert may have refilled the word after we emptied it
+        if (atomic_load(word) != 0)
+            cveb_set(tree, level + 1, index >> 6);
+    }
+    return 1;
+}
+
+// Function to find the first set bit >= index of a level, or -1
+int cveb_next(ConcurrentVEB *tree, int level, int index)
+{
+    while (index < tree->level_bits[level])
+    {
+        int w = index >> 6;
+        uint64_t word = atomic_load(&tree->levels[level][w]) & (~0ULL << (index & 63));
+        if (word)
+            return w * 64 + __builtin_ctzll(word);
+        if (level + 1 == tree->num_levels)
+            return -1;
+
+        // Ask the level above for the next non-empty word, it may be stale so loop to verify
+        int next_word = cveb_next(tree, level + 1, w + 1);
+        if (next_word == -1)
+            return -1;
+        index = next_word * 64;
+    }
+    return -1;
+}
+
+// Key insertion, safe to call from any number of threads, returns 1 if the key was new
+int concurrent_insert(ConcurrentVEB *tree, int key)
+{
+    if (!tree || key < 0 || key >= tree->u)
+        return 0;
+    return !(cveb_set(tree, 0, key) & (1ULL << (key & 63)));
+}
+
+// Key deletion, safe to call from any number of threads, returns 1 if the key was present
+int concurrent_delete(ConcurrentVEB *tree, int key)
+{
+    if (!tree || key < 0 || key >= tree->u)
+        return 0;
+    return cveb_clear(tree, 0, key);
+}
+
+int concurrent_is_member(ConcurrentVEB *tree, int key)
+{
+    if (!tree || key < 0 || key >= tree->u)
+        return 0;
+    return (atomic_load(&tree->levels[0][key >> 6]) >> (key & 63)) & 1;
+}
+
+// Function to find the successor of a given key, key = -1 gives the minimum
+int concurrent_successor(ConcurrentVEB *tree, int key)
+{
+    if (!tree || key >= tree->u - 1)
+        return -1;
+    return cveb_next(tree, 0, key < 0 ? 0 : key + 1);
+}
+
+// Function to count keys in [lo, hi] by popcount over the key words
+int concurrent_range_count(ConcurrentVEB *tree, int lo, int hi)
+{
+    if (!tree)
+        return 0;
+    if (lo < 0)
+        lo = 0;
+    if (hi >= tree->u)
+        hi = tree->u - 1;
+
+    int count = 0;
+    for (int w = lo >> 6; lo <= hi && w <= hi >> 6; w++)
+    {
+        uint64_t word = atomic_load(&tree->levels[0][w]);
+        if (w == lo >> 6)
+            word &= ~0ULL << (lo & 63);
+        if (w == hi >> 6 && (hi & 63) != 63)
+            word &= (1ULL << ((hi & 63) + 1)) - 1;
+        count += __builtin_popcountll(word);
+    }
+    return count;
+}
+
+// Cleanup function, must not run concurrently with any other operation
+void free_concurrent_vEB(ConcurrentVEB *tree)
+{
+    if (!tree)
+        return;
+
+    for (int i = 0; i < tree->num_levels; i++)
+    {
+        free((void *)tree->levels[i]);
+    }
+    free(tree);
+}
+
+//                      APPROXIMATE CONGESTION COUNTER
+
+// Counts occupied positions per bucket, the same quantity the trees count, and
+// answers a window count from two prefix sums, interpolating inside the two
+// buckets at its ends. Buckets fully inside the window are counted exactly.
+// An end bucket of width w with c occupied positions, of which the window
+// covers a fraction f, is estimated as c * f while the truth lies in
+// [c - (1 - f) * w, f * w], so its error is at most f * (1 - f) * w <= w / 4.
+// Buckets are 2 * max_error wide, which keeps the total error of a window
+// within max_error positions.
+typedef struct ApproxCounter
+{
+    int u;
+    int resolution; // Bucket width in meters
+    int num_buckets;
+    uint64_t *occupied; // One bit per position, so a shared position is counted once
+    int *counts;        // Occupied positions per bucket
+    int *prefix;        // prefix[i] = occupied positions in buckets [0, i), rebuilt on the first query after an update
+    bool dirty;
+} ApproxCounter;
+
+// max_error = 0 gives buckets of one position, which makes the counts exact
+ApproxCounter *create_approx(int size, int max_error)
+{
+    if (size <= 0 || max_error < 0)
+        return NULL;
+
+    ApproxCounter *c = (ApproxCounter *)malloc(sizeof(ApproxCounter));
+    c->u = size;
+    c->resolution = max_error > 0 ? 2 * max_error : 1;
+    c->num_buckets = (size + c->resolution - 1) / c->resolution;
+    c->occupied = (uint64_t *)calloc((size + 63) / 64, sizeof(uint64_t));
+    c->counts = (int *)calloc(c->num_buckets, sizeof(int));
+    c->prefix = (int *)calloc(c->num_buckets + 1, sizeof(int));
+    c->dirty = false;
+    return c;
+}
+
+void approx_add(ApproxCounter *c, int key)
+{
+    if (!c || key < 0 || key >= c->u || (c->occupied[key >> 6] >> (key & 63)) & 1)
+        return;
+    c->occupied[key >> 6] |= 1ULL << (key & 63);
+    c->counts[key / c->resolution]++;
+    c->dirty = true;
+}
+
+void approx_remove(ApproxCounter *c, int key)
+{
+    if (!c || key < 0 || key >= c->u || !((c->occupied[key >> 6] >> (key & 63)) & 1))
+        return;
+    c->occupied[key >> 6] &= ~(1ULL << (key & 63));
+    c->counts[key / c->resolution]--;
+    c->dirty = true;
+}
+
+// Function to estimate the number of occupied positions in [lo, hi] in O(1)
+// The first query after an update first rebuilds prefix in O(u / resolution)
+int approx_range_count(ApproxCounter *c, int lo, int hi)
+{
+    if (!c)
+        return 0;
+    if (lo < 0)
+        lo = 0;
+    if (hi >= c->u)
+        hi = c->u - 1;
+    if (lo > hi)
+        return 0;
+
+    if (c->dirty)
+    {
+        for (int i = 0; i < c->num_buckets; i++)
+        {
+            c->prefix[i + 1] = c->prefix[i] + c->counts[i];
+        }
+        c->dirty = false;
+    }
+
+    int first = lo / c->resolution;
+    int last = hi / c->resolution;
+    if (first == last)
+        return (int)((double)c->counts[first] * (hi - lo + 1) / c->resolution + 0.5);
+
+    double estimate = c->prefix[last] - c->prefix[first + 1];
+    estimate += (double)c->counts[first] * ((first + 1) * c->resolution - lo) / c->resolution;
+    estimate += (double)c->counts[last] * (hi - last * c->resolution + 1) / c->resolution;
+    return (int)(estimate + 0.5);
+}
+
+void free_approx(ApproxCounter *c)
+{
+    if (!c)
+        return;
+    free(c->occupied);
+    free(c->counts);
+    free(c->prefix);
+    free(c);
+}
+
+//                      TRAFFIC CONGESTION ALERT IMPLEMENTATION
+
+#define Max_distance 30000
+#define min_dist 1000
+#define max_dist 3000
+
+// Define a point with only an x-coordinate and speed
+typedef struct Point
+{
+    int x;
+    int speed;
+} Point;
+
+// Function to load points from input file, the array grows with the file
+Point *load_points(const char *filename, int *n)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        perror("Error opening file");
+        exit(1);
+    }
+
+    int capacity = 128;
+    Point *points = (Point *)malloc(capacity * sizeof(Point));
+    Point p;
+
+    *n = 0;
+    while (fscanf(file, "%d %d", &p.x, &p.speed) == 2)
+    {
+        if (*n == capacity)
+        {
+            capacity *= 2;
+            points = (Point *)realloc(points, capacity * sizeof(Point));
+        }
+        points[(*n)++] = p;
+    }
+
+    fclose(file);
+    return points;
+}
+
+// Function to count vehicles within a specific range of distances using successor function in Van Emde Boas tree
+int count_vehicles_in_range(vEBTree *veb_tree, int input_distance, int min_distance, int max_distance)
+{
+    if (!veb_tree)
+        return 0;
+    int count = 0;
+
+    // Calculate the actual distances from input_x to search within
+    int lower_bound = input_distance + min_distance;
+    int upper_bound = input_distance + max_distance;
+
+    // Start finding successors from the lower_bound
+    int current_distance = vEB_successor(veb_tree, lower_bound - 1);
+
+    while (current_distance != -1 && current_distance <= upper_bound)
+    {
+        count++;
+        current_distance = vEB_successor(veb_tree, current_distance);
+    }
+
+    return count;
+}
+
+// Function to print all elements in the Van Emde Boas tree in sorted order
+void print_all_elements(vEBTree *vEB)
+{
+    if (!vEB)
+        return;
+    int current = vEB_min(vEB); // Start from the minimum element
+
+    // Traverse through all elements using successor function
+    while (current != -1)
+    {
+        printf("%d ", current);                // Print the current element
+        current = vEB_successor(vEB, current); // Move to the next element
+    }
+    printf("\n"); // Newline after printing all elements
+}
+
+// Index of the vehicles of one tick, only the field matching its kind is used
+typedef enum IndexKind
+{
+    INDEX_VEB,
+    INDEX_ADAPTIVE,
+    INDEX_CONCURRENT,
+    INDEX_APPROX
+} IndexKind;
+
+typedef struct TickIndex
+{
+    vEBTree *tree;
+    AdaptiveSet *adaptive;
+    ConcurrentVEB *concurrent;
+    ApproxCounter *approx;
+} TickIndex;
+
+// max_error is only used by INDEX_APPROX
+TickIndex create_tick_index(IndexKind kind, int max_error)
+{
+    TickIndex index = {NULL, NULL, NULL, NULL};
+    if (kind == INDEX_APPROX)
+        index.approx = create_approx(32768, max_error);
+    else if (kind == INDEX_ADAPTIVE)
+        index.adaptive = create_adaptive(32768); // Assuming at most 30 km
+    else if (kind == INDEX_CONCURRENT)
+        index.concurrent = create_concurrent_vEB(32768);
+    else
+        index.tree = create_vEB(32768);
+    return index;
+}
+
+void tick_insert(TickIndex *index, int key)
+{
+    if (index->approx)
+        approx_add(index->approx, key);
+    else if (index->adaptive)
+        adaptive_insert(index->adaptive, key);
+    else if (index->concurrent)
+        concurrent_insert(index->concurrent, key);
+    else
+        insert(index->tree, key);
+}
+
+int tick_count_in_range(TickIndex *index, int input_distance, int min_distance, int max_distance)
+{
+    if (index->approx)
+        return approx_range_count(index->approx, input_distance + min_distance, input_distance + max_distance);
+    if (index->adaptive)
+        return adaptive_range_count(index->adaptive, input_distance + min_distance, input_distance + max_distance);
+    if (index->concurrent)
+        return concurrent_range_count(index->concurrent, input_distance + min_distance, input_distance + max_distance);
+    return count_vehicles_in_range(index->tree, input_distance, min_distance, max_distance);
+}
+
+void tick_print_all(TickIndex *index)
+{
+    if (index->tree)
+    {
+        print_all_elements(index->tree);
+        return;
+    }
+
+    // Only bucket totals are kept, printed as <first position>-<last position>:<occupied positions>
+    if (index->approx)
+    {
+        ApproxCounter *c = index->approx;
+        for (int i = 0; i < c->num_buckets; i++)
+        {
+            if (c->counts[i])
+                printf("%d-%d:%d ", i * c->resolution, (i + 1) * c->resolution - 1, c->counts[i]);
+        }
+        printf("\n");
+        return;
+    }
+
+    int current = index->adaptive ? adaptive_min(index->adaptive) : concurrent_successor(index->concurrent, -1);
+    while (current != -1)
+    {
+        printf("%d ", current);
+        current = index->adaptive ? adaptive_successor(index->adaptive, current) : concurrent_successor(index->concurrent, current);
+    }
+    printf("\n");
+}
+
+void free_tick_index(TickIndex *index)
+{
+    free_vEB(index->tree);
+    free_adaptive(index->adaptive);
+    free_concurrent_vEB(index->concurrent);
+    free_approx(index->approx);
+}
+
+// Function to empty the index for the next tick
+// The plain vEB tree is kept and emptied in O(1) by vEB_delete_range, which saves allocating
+// and freeing all of its nodes every tick. The other kinds are built again.
+void reset_tick_index(TickIndex *index, IndexKind kind, int max_error)
+{
+    if (index->tree)
+    {
+        vEB_delete_range(index->tree, 0, index->tree->u - 1);
+        return;
+    }
+    free_tick_index(index);
+    *index = create_tick_index(kind, max_error);
+}
+
+// Function to write the keys of the index to out in ascending order, returns how many
+// The approximate counter keeps no keys, so it returns 0
+int tick_collect(TickIndex *index, int *out)
+{
+    int n = 0;
+    if (index->tree)
+    {
+        for (int current = vEB_min(index->tree); current != -1; current = vEB_successor(index->tree, current))
+            out[n++] = current;
+    }
+    else if (index->adaptive)
+    {
+        for (int current = adaptive_min(index->adaptive); current != -1; current = adaptive_successor(index->adaptive, current))
+            out[n++] = current;
+    }
+    else if (index->concurrent)
+    {
+        for (int current = concurrent_successor(index->concurrent, -1); current != -1; current = concurrent_successor(index->concurrent, current))
+            out[n++] = current;
+    }
+    return n;
+}
+
+//                      MULTI-SUBSCRIBER ALERT ENGINE
+
+// One rule: an observer moving at speed that watches [x + min_offset, x + max_offset]
+typedef struct Subscription
+{
+    int x;
+    int speed;
+    int min_offset;
+    int max_offset;
+    int threshold;
+    bool congested; // State after the last tick, an alert is only emitted when it changes
+} Subscription;
+
+// Start or end of a window, starts sort before ends at the same position
+typedef struct WindowEdge
+{
+    long key; // 2 * position, + 1 for an end
+    int position;
+    int id; // 2 * subscriber, + 1 for an end
+} WindowEdge;
+
+typedef struct AlertEvent
+{
+    int subscriber;
+    int count;
+    bool congested;
+} AlertEvent;
+
+// All windows are evaluated together: the edges of every window are kept
+// sorted across ticks and merged with the sorted positions of the tick in a
+// single pass, so a subscriber costs O(1) plus its share of the re-sort.
+typedef struct SubscriptionEngine
+{
+    Subscription *subs;
+    int num_subs;
+    WindowEdge *edges;
+    int *counts;
+    int *keys; // Sorted positions of the current tick
+} SubscriptionEngine;
+
+// Function to load rules, one "<x_coordinate> <speed> <min_offset> <max_offset> <threshold>" per line
+SubscriptionEngine *load_subscriptions(const char *filename)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        perror("Error opening subscriptions file");
+        exit(1);
+    }
+
+    int capacity = 16;
+    SubscriptionEngine *e = (SubscriptionEngine *)malloc(sizeof(SubscriptionEngine));
+    e->subs = (Subscription *)malloc(capacity * sizeof(Subscription));
+    e->num_subs = 0;
+
+    Subscription s;
+    s.congested = false;
+    while (fscanf(file, "%d %d %d %d %d", &s.x, &s.speed, &s.min_offset, &s.max_offset, &s.threshold) == 5)
+    {
+        // The merge in evaluate_subscriptions needs every window to start before it ends
+        if (s.min_offset > s.max_offset)
+        {
+            fprintf(stderr, "Subscriber %d: min_offset %d is greater than max_offset %d, swapping them\n",
+                    e->num_subs, s.min_offset, s.max_offset);
+            int temp = s.min_offset;
+            s.min_offset = s.max_offset;
+            s.max_offset = temp;
+        }
+
+        if (e->num_subs == capacity)
+        {
+            capacity *= 2;
+            e->subs = (Subscription *)realloc(e->subs, capacity * sizeof(Subscription));
+        }
+        e->subs[e->num_subs++] = s;
+    }
+    fclose(file);
+
+    e->edges = (WindowEdge *)malloc((2 * e->num_subs + 1) * sizeof(WindowEdge));
+    for (int i = 0; i < 2 * e->num_subs; i++)
+    {
+        e->edges[i].id = i;
+    }
+    e->counts = (int *)calloc(e->num_subs + 1, sizeof(int));
+    e->keys = (int *)malloc(32768 * sizeof(int)); // Assuming at most 30 km
+    return e;
+}
+
+int compare_edges(const void *a, const void *b)
+{
+    long x = ((const WindowEdge *)a)->key;
+    long y = ((const WindowEdge *)b)->key;
+    return (x > y) - (x < y);
+}
+
+// Observers move little between ticks, so insertion sort on the previous order is
+// close to linear. If it has to move too many edges it falls back to qsort.
+void sort_edges(SubscriptionEngine *e)
+{
+    int n = 2 * e->num_subs;
+    long budget = 8L * n;
+
+    for (int i = 1; i < n; i++)
+    {
+        WindowEdge edge = e->edges[i];
+        int j = i;
+        while (j > 0 && e->edges[j - 1].key > edge.key)
+        {
+            e->edges[j] = e->edges[j - 1];
+            j--;
+            if (--budget < 0)
+            {
+                e->edges[j] = edge;
+                qsort(e->edges, n, sizeof(WindowEdge), compare_edges);
+                return;
+            }
+        }
+        e->edges[j] = edge;
+    }
+}
+
+// Function to evaluate every rule against the index of one tick
+// Returns the number of rules whose state changed and stores them in *events
+int evaluate_subscriptions(SubscriptionEngine *e, TickIndex *index, AlertEvent **events)
+{
+    if (index->approx)
+    {
+        for (int i = 0; i < e->num_subs; i++)
+        {
+            Subscription *s = &e->subs[i];
+            e->counts[i] = approx_range_count(index->approx, s->x + s->min_offset, s->x + s->max_offset);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < 2 * e->num_subs; i++)
+        {
+            WindowEdge *edge = &e->edges[i];
+            Subscription *s = &e->subs[edge->id / 2];
+            edge->position = s->x + ((edge->id & 1) ? s->max_offset : s->min_offset);
+            edge->key = 2L * edge->position + (edge->id & 1);
+        }
+        sort_edges(e);
+
+        // A window counts the keys <= its end minus the keys < its start
+        int n = tick_collect(index, e->keys);
+        int j = 0;
+        for (int i = 0; i < 2 * e->num_subs; i++)
+        {
+            WindowEdge *edge = &e->edges[i];
+            if (edge->id & 1)
+            {
+                while (j < n && e->keys[j] <= edge->position)
+                    j++;
+                e->counts[edge->id / 2] += j;
+            }
+            else
+            {
+                while (j < n && e->keys[j] < edge->position)
+                    j++;
+                e->counts[edge->id / 2] = -j;
+            }
+        }
+    }
+
+    int num_events = 0;
+    int capacity = 0;
+    *events = NULL;
+    for (int i = 0; i < e->num_subs; i++)
+    {
+        Subscription *s = &e->subs[i];
+        bool congested = e->counts[i] >= s->threshold;
+        if (congested == s->congested)
+            continue;
+
+        s->congested = congested;
+        if (num_events == capacity)
+        {
+            capacity = capacity ? 2 * capacity : 16;
+            *events = (AlertEvent *)realloc(*events, capacity * sizeof(AlertEvent));
+        }
+        (*events)[num_events].subscriber = i;
+        (*events)[num_events].count = e->counts[i];
+        (*events)[num_events].congested = congested;
+        num_events++;
+    }
+    return num_events;
+}
+
+// Moves every observer to its position at the next tick
+void advance_subscriptions(SubscriptionEngine *e)
+{
+    for (int i = 0; i < e->num_subs; i++)
+    {
+        e->subs[i].x += e->subs[i].speed;
+    }
+}
+
+void print_alert_events(AlertEvent *events, int n, int t)
+{
+    for (int i = 0; i < n; i++)
+    {
+        printf("Subscriber %d: %s at time %d, %d vehicles in range\n", events[i].subscriber,
+               events[i].congested ? "Congestion alert" : "Congestion cleared", t, events[i].count);
+    }
+}
+
+void free_subscriptions(SubscriptionEngine *e)
+{
+    if (!e)
+        return;
+    free(e->subs);
+    free(e->edges);
+    free(e->counts);
+    free(e->keys);
+    free(e);
+}
+
+#define MAX_INGEST_THREADS 64
+
+struct IngestPool;
+
+// Identifies one ingest thread, which inserts its share of each job
+typedef struct IngestSlice
+{
+    struct IngestPool *pool;
+    int index;
+} IngestSlice;
+
+// Ingest threads are started once and reused for every tick
+typedef struct IngestPool
+{
+    int num_threads;
+    pthread_t threads[MAX_INGEST_THREADS];
+    IngestSlice slices[MAX_INGEST_THREADS];
+    pthread_mutex_t submit_lock; // Index workers sharing the pool submit one job at a time
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    int generation; // Incremented for every job
+    int pending;    // Threads still working on the current job
+    bool stop;
+    ConcurrentVEB *tree;
+    const int *positions;
+    int n;
+} IngestPool;
+
+void *ingest_worker(void *arg)
+{
+    IngestSlice *slice = (IngestSlice *)arg;
+    IngestPool *pool = slice->pool;
+    int seen = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->stop)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        ConcurrentVEB *tree = pool->tree;
+        const int *positions = pool->positions;
+        int begin = (int)((long)pool->n * slice->index / pool->num_threads);
+        int end = (int)((long)pool->n * (slice->index + 1) / pool->num_threads);
+        pthread_mutex_unlock(&pool->lock);
+
+        for (int i = begin; i < end; i++)
+        {
+            if (positions[i] <= Max_distance)
+            {
+                concurrent_insert(tree, positions[i]);
+            }
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// Function to start num_threads ingest threads, at most MAX_INGEST_THREADS
+// If a thread cannot be created the pool keeps the ones already running
+IngestPool *create_ingest_pool(int num_threads)
+{
+    IngestPool *pool = (IngestPool *)calloc(1, sizeof(IngestPool));
+    pthread_mutex_init(&pool->submit_lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    if (num_threads > MAX_INGEST_THREADS)
+        num_threads = MAX_INGEST_THREADS;
+    for (int i = 0; i < num_threads; i++)
+    {
+        pool->slices[i].pool = pool;
+        pool->slices[i].index = i;
+        int err = pthread_create(&pool->threads[i], NULL, ingest_worker, &pool->slices[i]);
+        if (err)
+        {
+            fprintf(stderr, "Error starting ingest thread %d: %s, using %d\n", i, strerror(err), i);
+            break;
+        }
+        pool->num_threads++;
+    }
+    return pool;
+}
+
+// Inserts all positions on the road into the concurrent tree using the threads of the pool
+void ingest_positions(IngestPool *pool, ConcurrentVEB *tree, const int *positions, int n)
+{
+    if (pool->num_threads == 0)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            if (positions[i] <= Max_distance)
+                concurrent_insert(tree, positions[i]);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool->submit_lock);
+    pthread_mutex_lock(&pool->lock);
+    pool->tree = tree;
+    pool->positions = positions;
+    pool->n = n;
+    pool->pending = pool->num_threads;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->submit_lock);
+}
+
+void free_ingest_pool(IngestPool *pool)
+{
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->num_threads; i++)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->submit_lock);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool);
+}
+
+//                      PIPELINED TICK ENGINE
+
+#define PIPELINE_DEPTH 4    // Number of ticks buffered between two stages
+#define MAX_INDEX_WORKERS 8 // Trees of consecutive ticks built at the same time
+#define MAX_SPARE_INDEXES (MAX_INDEX_WORKERS + 2 * PIPELINE_DEPTH + 2) // Ticks holding an index at once
+
+// Everything a single tick needs while it moves through the pipeline stages
+typedef struct TickFrame
+{
+    int t;
+    int input_x;
+    int *positions; // Snapshot of the vehicle positions at time t
+    TickIndex index;
+    int *evicted; // Positions of the vehicles removed at time t
+    int num_evicted;
+    int remaining;
+    int count;
+    AlertEvent *events; // State changes of the subscribers at time t
+    int num_events;
+} TickFrame;
+
+// Bounded FIFO between two stages, a NULL frame marks the end of the run
+typedef struct FrameQueue
+{
+    TickFrame *slots[PIPELINE_DEPTH];
+    int head;
+    int size;
+    int next_t; // Next tick accepted by push_frame_in_order
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} FrameQueue;
+
+typedef struct Pipeline
+{
+    Point *points;
+    int num_points;
+    float input_x;
+    int input_speed;
+    int input_time;
+    int congestion_threshold;
+    IndexKind index_kind;
+    IngestPool *ingest_pool; // Threads filling a concurrent index, NULL to insert on the index worker
+    int approx_max_error;
+    SubscriptionEngine *subscriptions; // Replaces the single observer when not NULL
+    bool *deleted_points;
+    FILE *delete_file;
+    int num_index_workers;
+    int finished_index_workers;
+    pthread_mutex_t finish_lock;
+    TickIndex spare_indexes[MAX_SPARE_INDEXES]; // Emptied indexes of logged ticks, reused by the index stage
+    int num_spare_indexes;
+    pthread_mutex_t spare_lock;
+    FrameQueue to_index;
+    FrameQueue to_query;
+    FrameQueue to_log;
+} Pipeline;
+
+void init_queue(FrameQueue *q)
+{
+    q->head = 0;
+    q->size = 0;
+    q->next_t = 0;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+}
+
+void destroy_queue(FrameQueue *q)
+{
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+}
+
+// Blocks while the queue is full so a fast stage cannot run ahead of a slow one
+void push_frame(FrameQueue *q, TickFrame *frame)
+{
+    pthread_mutex_lock(&q->lock);
+    while (q->size == PIPELINE_DEPTH)
+        pthread_cond_wait(&q->not_full, &q->lock);
+    q->slots[(q->head + q->size) % PIPELINE_DEPTH] = frame;
+    q->size++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+}
+
+// Like push_frame for several producers, frames are released strictly in tick order
+void push_frame_in_order(FrameQueue *q, TickFrame *frame)
+{
+    pthread_mutex_lock(&q->lock);
+    while (q->size == PIPELINE_DEPTH || q->next_t != frame->t)
+        pthread_cond_wait(&q->not_full, &q->lock);
+    q->slots[(q->head + q->size) % PIPELINE_DEPTH] = frame;
+    q->size++;
+    q->next_t++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_cond_broadcast(&q->not_full); // The producer of the next tick may be waiting
+    pthread_mutex_unlock(&q->lock);
+}
+
+TickFrame *pop_frame(FrameQueue *q)
+{
+    pthread_mutex_lock(&q->lock);
+    while (q->size == 0)
+        pthread_cond_wait(&q->not_empty, &q->lock);
+    TickFrame *frame = q->slots[q->head];
+    q->head = (q->head + 1) % PIPELINE_DEPTH;
+    q->size--;
+    pthread_cond_broadcast(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+    return frame;
+}
+
+// Stage 1: snapshot the positions of tick t and collect the vehicles that left the road,
+// then move every vehicle to tick t + 1. Only this thread touches deleted_points.
+void *update_stage(void *arg)
+{
+    Pipeline *p = (Pipeline *)arg;
+    int remaining_points = p->num_points;
+    for (int t = 0; t < p->input_time; t++)
+    {
+        int capacity = 0;
+        TickFrame *frame = (TickFrame *)calloc(1, sizeof(TickFrame));
+        frame->t = t;
+        frame->input_x = p->input_x;
+        frame->positions = (int *)malloc(p->num_points * sizeof(int));
+        for (int i = 0; i < p->num_points; i++)
+        {
+            frame->positions[i] = p->points[i].x;
+            if (p->points[i].x > Max_distance && !p->deleted_points[i])
+            {
+                if (frame->num_evicted == capacity)
+                {
+                    capacity = capacity ? 2 * capacity : 16;
+                    frame->evicted = (int *)realloc(frame->evicted, capacity * sizeof(int));
+                }
+                frame->evicted[frame->num_evicted++] = p->points[i].x;
+                p->deleted_points[i] = true;
+                remaining_points--;
+            }
+        }
+        frame->remaining = remaining_points;
+        push_frame(&p->to_index, frame);
+
+        for (int i = 0; i < p->num_points; i++)
+        {
+            p->points[i].x += p->points[i].speed;
+        }
+        p->input_x += p->input_speed;
+    }
+    for (int i = 0; i < p->num_index_workers; i++)
+    {
+        push_frame(&p->to_index, NULL); // One end marker per index worker
+    }
+    return NULL;
+}
+
+// Function to reuse the index of a logged tick, or build a new one when there is none
+TickIndex take_tick_index(Pipeline *p)
+{
+    TickIndex index;
+    pthread_mutex_lock(&p->spare_lock);
+    bool found = p->num_spare_indexes > 0;
+    if (found)
+        index = p->spare_indexes[--p->num_spare_indexes];
+    pthread_mutex_unlock(&p->spare_lock);
+
+    if (!found)
+        index = create_tick_index(p->index_kind, p->approx_max_error);
+    return index;
+}
+
+// Function to empty the index of a logged tick and keep it for a later tick
+void return_tick_index(Pipeline *p, TickIndex *index)
+{
+    reset_tick_index(index, p->index_kind, p->approx_max_error);
+    pthread_mutex_lock(&p->spare_lock);
+    bool kept = p->num_spare_indexes < MAX_SPARE_INDEXES;
+    if (kept)
+        p->spare_indexes[p->num_spare_indexes++] = *index;
+    pthread_mutex_unlock(&p->spare_lock);
+
+    if (!kept)
+        free_tick_index(index);
+}
+
+// Stage 2: build the tree of tick t. Building is the most expensive stage, so several
+// workers build the trees of consecutive ticks at once and hand them on in tick order.
+void *index_stage(void *arg)
+{
+    Pipeline *p = (Pipeline *)arg;
+    TickFrame *frame;
+    while ((frame = pop_frame(&p->to_index)) != NULL)
+    {
+        frame->index = take_tick_index(p);
+
+        bool ingested = frame->index.concurrent && p->ingest_pool;
+        if (ingested)
+            ingest_positions(p->ingest_pool, frame->index.concurrent, frame->positions, p->num_points);
+
+        for (int i = 0; i < p->num_points && !ingested; i++)
+        {
+            if (frame->positions[i] <= Max_distance)
+            {
+                tick_insert(&frame->index, frame->positions[i]);
+            }
+        }
+        free(frame->positions);
+        frame->positions = NULL;
+        push_frame_in_order(&p->to_query, frame);
+    }
+
+    // The last worker to stop ends the stream, every frame has been handed on by then
+    pthread_mutex_lock(&p->finish_lock);
+    bool last = (++p->finished_index_workers == p->num_index_workers);
+    pthread_mutex_unlock(&p->finish_lock);
+    if (last)
+        push_frame(&p->to_query, NULL);
+    return NULL;
+}
+
+// Stage 3: run the congestion query of tick t against its own tree
+// The subscription engine is only used by this thread, one tick after the other
+void *query_stage(void *arg)
+{
+    Pipeline *p = (Pipeline *)arg;
+    TickFrame *frame;
+    while ((frame = pop_frame(&p->to_query)) != NULL)
+    {
+        if (p->subscriptions)
+        {
+            frame->num_events = evaluate_subscriptions(p->subscriptions, &frame->index, &frame->events);
+            advance_subscriptions(p->subscriptions);
+        }
+        else
+        {
+            frame->count = tick_count_in_range(&frame->index, frame->input_x, min_dist, max_dist);
+        }
+        push_frame(&p->to_log, frame);
+    }
+    push_frame(&p->to_log, NULL);
+    return NULL;
+}
+
+// Stage 4: write the results of tick t in the same format as the sequential loop
+void log_stage(Pipeline *p)
+{
+    TickFrame *frame;
+    while ((frame = pop_frame(&p->to_log)) != NULL)
+    {
+        for (int i = 0; i < frame->num_evicted; i++)
+        {
+            fprintf(p->delete_file, "Vehicle at position %d exceeded maximum distance and was removed at time %d.\n", frame->evicted[i], frame->t);
+        }
+
+        if (p->subscriptions)
+        {
+            print_alert_events(frame->events, frame->num_events, frame->t);
+        }
+        else
+        {
+            printf("Number of vehicles in range: %d\n", frame->count);
+            if (frame->count >= p->congestion_threshold)
+            {
+                printf("Congestion alert\n");
+            }
+            else
+            {
+                printf("No congestion\n");
+            }
+
+            printf("\n");
+        }
+
+        if (frame->t == p->input_time - 1)
+        {
+            printf("Number of vehicles remaining: %d\n", frame->remaining);
+            printf("Remaining elements in the vEB Tree:\n");
+            tick_print_all(&frame->index);
+        }
+
+        return_tick_index(p, &frame->index);
+        free(frame->evicted);
+        free(frame->events);
+        free(frame);
+    }
+}
+
+// Function to start a pipeline thread, the run cannot continue without it
+void start_stage(pthread_t *thread, void *(*stage)(void *), Pipeline *p)
+{
+    int err = pthread_create(thread, NULL, stage, p);
+    if (err)
+    {
+        fprintf(stderr, "Error starting pipeline thread: %s\n", strerror(err));
+        exit(1);
+    }
+}
+
+// Function to return the number of index workers for this machine, one per CPU
+int pipeline_index_workers(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus < 1 ? 1 : (cpus > MAX_INDEX_WORKERS ? MAX_INDEX_WORKERS : (int)cpus);
+}
+
+// Runs update, index, query and logging of consecutive ticks concurrently
+// Ticks reach the query and log stages in order, so the output is identical to the sequential loop
+void run_pipeline(Pipeline *p)
+{
+    pthread_t update_thread, query_thread;
+    pthread_t index_threads[MAX_INDEX_WORKERS];
+
+    init_queue(&p->to_index);
+    init_queue(&p->to_query);
+    init_queue(&p->to_log);
+    pthread_mutex_init(&p->finish_lock, NULL);
+    pthread_mutex_init(&p->spare_lock, NULL);
+    p->finished_index_workers = 0;
+    p->num_spare_indexes = 0;
+    p->num_index_workers = pipeline_index_workers();
+
+    // Index workers start first, the update stage sends one end marker to each of them
+    start_stage(&index_threads[0], index_stage, p);
+    for (int i = 1; i < p->num_index_workers; i++)
+    {
+        if (pthread_create(&index_threads[i], NULL, index_stage, p))
+        {
+            p->num_index_workers = i; // Fewer workers only cost throughput
+            break;
+        }
+    }
+    start_stage(&update_thread, update_stage, p);
+    start_stage(&query_thread, query_stage, p);
+
+    log_stage(p);
+
+    pthread_join(update_thread, NULL);
+    for (int i = 0; i < p->num_index_workers; i++)
+    {
+        pthread_join(index_threads[i], NULL);
+    }
+    pthread_join(query_thread, NULL);
+
+    for (int i = 0; i < p->num_spare_indexes; i++)
+    {
+        free_tick_index(&p->spare_indexes[i]);
+    }
+    pthread_mutex_destroy(&p->spare_lock);
+    pthread_mutex_destroy(&p->finish_lock);
+    destroy_queue(&p->to_index);
+    destroy_queue(&p->to_query);
+    destroy_queue(&p->to_log);
+}
+
+int main(int argc, char *argv[])
+{
+    bool pipelined = false; // Overlap consecutive ticks instead of sleeping between them
+    bool real_time = true;  // Sleep one second between ticks of the sequential loop
+    IndexKind index_kind = INDEX_VEB;
+    int ingest_threads = 1;    // Threads filling a concurrent index
+    int approx_max_error = 0;  // Largest error of an approximate window count
+    const char *input_file = "input.txt";
+    const char *subscriptions_file = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--pipeline") == 0)
+            pipelined = true;
+        else if (strcmp(argv[i], "--no-sleep") == 0)
+            real_time = false;
+        else if (strcmp(argv[i], "--adaptive") == 0)
+            index_kind = INDEX_ADAPTIVE;
+        else if (strcmp(argv[i], "--concurrent") == 0 && i + 1 < argc)
+        {
+            index_kind = INDEX_CONCURRENT;
+            ingest_threads = atoi(argv[++i]);
+            if (ingest_threads < 1 || ingest_threads > MAX_INGEST_THREADS)
+            {
+                int clamped = ingest_threads < 1 ? 1 : MAX_INGEST_THREADS;
+                fprintf(stderr, "--concurrent %d is out of range, using %d ingest threads\n", ingest_threads, clamped);
+                ingest_threads = clamped;
+            }
+        }
+        else if (strcmp(argv[i], "--approx") == 0 && i + 1 < argc)
+        {
+            index_kind = INDEX_APPROX;
+            approx_max_error = atoi(argv[++i]);
+            if (approx_max_error < 0)
+                approx_max_error = 0;
+        }
+        else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc)
+            input_file = argv[++i];
+        else if (strcmp(argv[i], "--subscriptions") == 0 && i + 1 < argc)
+            subscriptions_file = argv[++i];
+    }
+
+    // With a single index worker the stages only share one CPU, which is slower than the plain loop
+    if (pipelined && pipeline_index_workers() == 1)
+    {
+        fprintf(stderr, "--pipeline is slower on a single CPU, running the sequential loop without sleep\n");
+        pipelined = false;
+        real_time = false;
+    }
+
+    int num_points;
+
+    // Load points from input file
+    Point *points = load_points(input_file, &num_points);
+    printf("Number of vehicles loaded: %d\n", num_points);
+
+    float input_x = 0;
+    int input_speed = 0;
+    int congestion_threshold = 0;
+    SubscriptionEngine *subscriptions = NULL;
+    if (subscriptions_file)
+    {
+        // Every subscriber brings its own observer, window and threshold
+        subscriptions = load_subscriptions(subscriptions_file);
+        printf("Number of subscribers loaded: %d\n", subscriptions->num_subs);
+    }
+    else
+    {
+        printf("Enter the x_coordinate(in km) of vehicle to check for congestion between 0 to 30 km: ");
+
+        scanf("%f", &input_x);
+        printf("Enter speed(m/s) of vehicle whose coordinate you have given: ");
+        scanf("%d", &input_speed);
+
+        printf("Enter the Congestion threshold: ");
+        scanf("%d", &congestion_threshold);
+    }
+
+    // Check congestion after updating positions
+    int input_time;
+    printf("Enter for how many seconds you want to run the program: ");
+    scanf("%d", &input_time);
+
+    input_x *= 1000;                 // convert km to m
+    bool *deleted_points = (bool *)calloc(num_points, sizeof(bool)); // To keep track of deleted points
+
+    // Open delete file initially in write mode to create a new file for this run
+    FILE *delete_file = fopen("delete_output.txt", "w");
+    if (!delete_file)
+    {
+        perror("Error opening delete_output.txt");
+        exit(1);
+    }
+
+    // Single-threaded ingest needs no pool, the index is filled by tick_insert
+    IngestPool *ingest_pool = NULL;
+    if (index_kind == INDEX_CONCURRENT && ingest_threads > 1)
+        ingest_pool = create_ingest_pool(ingest_threads);
+
+    if (pipelined)
+    {
+        Pipeline pipeline;
+        pipeline.points = points;
+        pipeline.num_points = num_points;
+        pipeline.input_x = input_x;
+        pipeline.input_speed = input_speed;
+        pipeline.input_time = input_time;
+        pipeline.congestion_threshold = congestion_threshold;
+        pipeline.index_kind = index_kind;
+        pipeline.ingest_pool = ingest_pool;
+        pipeline.approx_max_error = approx_max_error;
+        pipeline.subscriptions = subscriptions;
+        pipeline.deleted_points = deleted_points;
+        pipeline.delete_file = delete_file;
+        run_pipeline(&pipeline);
+        free_ingest_pool(ingest_pool);
+        fclose(delete_file);
+        free_subscriptions(subscriptions);
+        free(deleted_points);
+        free(points);
+        return 0;
+    }
+
+    int t = 0;
+    int remaining_points = num_points;
+    int *positions = ingest_pool ? (int *)malloc(num_points * sizeof(int)) : NULL; // Handed to the ingest threads every tick
+    TickIndex index = create_tick_index(index_kind, approx_max_error); // Reused by every tick
+    while (t < input_time)
+    {
+        if (t > 0)
+            reset_tick_index(&index, index_kind, approx_max_error);
+        for (int i = 0; i < num_points; i++)
+        {
+            if (ingest_pool)
+            {
+                positions[i] = points[i].x;
+            }
+            if (points[i].x <= Max_distance)
+            {
+                if (!ingest_pool)
+                    tick_insert(&index, points[i].x);
+            }
+            else if (!deleted_points[i])
+            {
+                fprintf(delete_file, "Vehicle at position %d exceeded maximum distance and was removed at time %d.\n", points[i].x, t);
+                deleted_points[i] = true;
+                remaining_points--; // Decrease the number of points
+            }
+        }
+        if (ingest_pool)
+            ingest_positions(ingest_pool, index.concurrent, positions, num_points);
+
+        if (subscriptions)
+        {
+            AlertEvent *events;
+            int num_events = evaluate_subscriptions(subscriptions, &index, &events);
+            print_alert_events(events, num_events, t);
+            free(events);
+        }
+        else
+        {
+            int count = tick_count_in_range(&index, input_x, min_dist, max_dist);
+            printf("Number of vehicles in range: %d\n", count);
+            if (count >= congestion_threshold)
+            {
+                printf("Congestion alert\n");
+            }
+            else
+            {
+                printf("No congestion\n");
+            }
+
+            printf("\n");
+        }
+
+        if (t == input_time - 1)
+        {
+            printf("Number of vehicles remaining: %d\n", remaining_points);
+            printf("Remaining elements in the vEB Tree:\n");
+            tick_print_all(&index);
+        }
 
         // Update positions of all vehicles
         for (int i = 0; i < num_points; i++)
@@ -400,12 +2336,21 @@ int main()
             points[i].x += points[i].speed;
         }
         input_x += input_speed;
+        if (subscriptions)
+            advance_subscriptions(subscriptions);
 
         t++;
-        sleep(1);
+        if (real_time)
+            sleep(1);
     }
 
     // Clean up and close the file
+    free_tick_index(&index);
+    free_ingest_pool(ingest_pool);
+    free(positions);
     fclose(delete_file);
+    free_subscriptions(subscriptions);
+    free(deleted_points);
+    free(points);
     return 0;
 }
\ No newline at end of file